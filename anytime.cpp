@@ -0,0 +1,362 @@
+// File: anytime.cpp
+//
+// Anytime, resumable branch and bound variant of the exhaustive approach.
+// It returns the best schedule found so far and a proven lower bound by
+// the given deadline.
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+
+#include "anytime.h"
+#include "solverutil.h"
+
+const size_t CAnytimeSearch::maxHikers;
+const size_t CAnytimeSearch::maxVisitedStates;
+
+SSearchBudget::SSearchBudget() : maxNodes(0), timeLimit(0) {}
+
+SSearchBudget::SSearchBudget(size_t maxNodes, std::chrono::microseconds timeLimit)
+    : maxNodes(maxNodes), timeLimit(timeLimit) {}
+
+
+CAnytimeSearch::CAnytimeSearch(const std::vector<SHiker>& hikers, double bridgeLength)
+    : hikers(hikers), all(0), minTime(0), bestCost(infinity), nodes(0)
+{
+    if (hikers.size() > maxHikers) {
+        throw std::out_of_range("Too many hikers for the anytime search");
+    }
+
+    // Fastest hikers first, so that the first schedules tried are the good ones.
+    std::stable_sort(this->hikers.begin(), this->hikers.end(), bySpeed);
+
+    for (size_t i = 0; i < this->hikers.size(); ++i) {
+        times.push_back(bridgeLength / this->hikers[i].speed);
+        all |= uint64_t(1) << i;
+    }
+    if (times.size()) {
+        minTime = times[0];
+    }
+
+    if (all) {
+        SFrame root = { all, true, 0, -1, -1, -1, -1, lowerBoundToCross(all, true), false };
+        stack.push_back(root);
+        seedBest();
+    }
+    else {
+        // Nobody to cross
+        bestCost = 0;
+    }
+}
+
+CAnytimeSearch::~CAnytimeSearch() {
+}
+
+bool CAnytimeSearch::isComplete() const {
+    return stack.empty();
+}
+
+// Advance the cursor of the frame to its next move. Returns false when all
+// moves from this node are tried.
+bool CAnytimeSearch::nextMove(SFrame& frame) const {
+    int n = static_cast<int>(times.size());
+
+    if (!frame.bForward) {
+        // One hiker from the right comes back
+        uint64_t right = all & ~frame.left;
+        for (int a = frame.nextA + 1; a < n; ++a) {
+            if (right & (uint64_t(1) << a)) {
+                frame.nextA = a;
+                frame.nextB = -1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Lone hiker crosses alone
+    if (countHikers(frame.left) == 1) {
+        if (frame.nextA >= 0) {
+            return false;
+        }
+        for (int a = 0; a < n; ++a) {
+            if (frame.left & (uint64_t(1) << a)) {
+                frame.nextA = a;
+                frame.nextB = -1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Pair of hikers from the left goes forward
+    int a = frame.nextA < 0 ? 0 : frame.nextA;
+    int b = frame.nextA < 0 ? 0 : frame.nextB + 1;
+    for (; a < n; ++a, b = 0) {
+        if (!(frame.left & (uint64_t(1) << a))) {
+            continue;
+        }
+        for (b = std::max(b, a + 1); b < n; ++b) {
+            if (frame.left & (uint64_t(1) << b)) {
+                frame.nextA = a;
+                frame.nextB = b;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Sum of the time of the slowest in each pair, when the hikers on the left
+// (and an extra hiker with the given time) are paired from slowest to fastest.
+// Each hiker is carried forward at least once and a forward move carries two
+// at most, so forward moves can't take less than this.
+double CAnytimeSearch::sumOfSlowestInPairs(uint64_t left, double extra) const {
+    double sum = 0;
+    bool bSlowestInPair = true;
+    bool bExtraPending = extra > 0;
+
+    for (int i = static_cast<int>(times.size()) - 1; i >= 0; --i) {
+        if (!(left & (uint64_t(1) << i))) {
+            continue;
+        }
+        if (bExtraPending && extra >= times[i]) {
+            if (bSlowestInPair) { sum += extra; }
+            bSlowestInPair = !bSlowestInPair;
+            bExtraPending = false;
+        }
+        if (bSlowestInPair) { sum += times[i]; }
+        bSlowestInPair = !bSlowestInPair;
+    }
+    if (bExtraPending && bSlowestInPair) {
+        sum += extra;
+    }
+    return sum;
+}
+
+// Lower bound of the time still needed for everyone to cross.
+//   - k hikers on the left with the torch need k-1 forward moves and k-2 moves
+//     back, each move back takes at least the time of the fastest hiker.
+//   - With the torch on the right, someone has to come back first.
+double CAnytimeSearch::lowerBoundToCross(uint64_t left, bool bForward) const {
+    // Everyone crossed
+    if (left == 0) {
+        return 0;
+    }
+    if (bForward) {
+        double k = static_cast<double>(countHikers(left));
+        if (k == 1) {
+            return sumOfSlowestInPairs(left, 0);
+        }
+        return sumOfSlowestInPairs(left, 0) + (k - 2) * minTime;
+    }
+
+    uint64_t right = all & ~left;
+    double minTimeRight = infinity;
+    for (size_t i = 0; i < times.size(); ++i) {
+        if (right & (uint64_t(1) << i)) {
+            minTimeRight = std::min(minTimeRight, times[i]);
+        }
+    }
+    double k = static_cast<double>(countHikers(left) + 1);
+    return minTimeRight + sumOfSlowestInPairs(left, minTimeRight) + (k - 2) * minTime;
+}
+
+// Start with the schedule of the optimized approach (Approach-1), so that there
+// is a good schedule to return from the beginning and more nodes get pruned.
+void CAnytimeSearch::seedBest() {
+    int k = static_cast<int>(times.size());
+    double cost = 0;
+
+    auto move = [&](int a, int b) {
+        cost += (b < 0) ? times[a] : std::max(times[a], times[b]);
+        bestMoves.push_back(std::make_pair(a, b));
+    };
+
+    bestMoves.clear();
+    for (; k > 3; k -= 2) {
+        double timeForCase1 = times[1] + times[0] + times[k - 1] + times[1];
+        double timeForCase2 = times[k - 1] + times[0] + times[k - 2] + times[0];
+        if (timeForCase1 <= timeForCase2) {
+            move(0, 1); move(0, -1); move(k - 2, k - 1); move(1, -1);
+        }
+        else {
+            move(0, k - 1); move(0, -1); move(0, k - 2); move(0, -1);
+        }
+    }
+    if (k == 3) {
+        move(0, 2); move(0, -1); move(0, 1);
+    }
+    else if (k == 2) {
+        move(0, 1);
+    }
+    else {
+        move(0, -1);
+    }
+    bestCost = cost;
+}
+
+// Lower bound of the schedules under the moves not yet tried from the node.
+// Gives up with the current bound of the frame once the deadline has passed.
+double CAnytimeSearch::lowerBoundOfUntriedMoves(const SFrame& frame,
+                                                std::chrono::steady_clock::time_point deadline,
+                                                bool bDeadline) const {
+    double bound = infinity;
+    SFrame cursor = frame;
+    for (size_t moves = 0; nextMove(cursor); ++moves) {
+        if (bDeadline && (moves & 0x3f) == 0 && std::chrono::steady_clock::now() >= deadline) {
+            return frame.bound;
+        }
+        uint64_t left = cursor.left ^ (uint64_t(1) << cursor.nextA);
+        double legCost = times[cursor.nextA];
+        if (cursor.nextB >= 0) {
+            legCost = std::max(legCost, times[cursor.nextB]);
+            left ^= uint64_t(1) << cursor.nextB;
+        }
+        bound = std::min(bound, cursor.cost + legCost + lowerBoundToCross(left, !cursor.bForward));
+    }
+    return bound;
+}
+
+// Tighten the bounds of the frames on the stack to the min over their untried
+// moves, from the root up, till the deadline. Each one takes n^3 time at most,
+// so it is charged to the budget of the search rather than done on every move.
+// A bound stays valid as the cursor advances, as fewer moves are left under it.
+void CAnytimeSearch::refineBounds(std::chrono::steady_clock::time_point deadline, bool bDeadline) {
+    for (auto& frame : stack) {
+        if (frame.bBoundExact) {
+            continue;
+        }
+        if (bDeadline && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        frame.bound = std::max(frame.bound, lowerBoundOfUntriedMoves(frame, deadline, bDeadline));
+        frame.bBoundExact = !bDeadline || std::chrono::steady_clock::now() < deadline;
+    }
+}
+
+// Record the time the state is reached in, returns false if it was reached
+// in no more time before. Once the table is full, new states are not recorded.
+bool CAnytimeSearch::isFirstVisit(uint64_t left, bool bForward, double cost) {
+    auto& states = visited[bForward ? 1 : 0];
+    auto it = states.find(left);
+    if (it != states.end()) {
+        if (it->second <= cost) {
+            return false;
+        }
+        it->second = cost;
+    }
+    else if (visited[0].size() + visited[1].size() < maxVisitedStates) {
+        states.emplace(left, cost);
+    }
+    return true;
+}
+
+// Keep the moves on the stack along with the last move as the best schedule.
+void CAnytimeSearch::recordBest(double cost, int moveA, int moveB) {
+    bestCost = cost;
+    bestMoves.clear();
+    for (size_t i = 1; i < stack.size(); ++i) {
+        bestMoves.push_back(std::make_pair(stack[i].moveA, stack[i].moveB));
+    }
+    bestMoves.push_back(std::make_pair(moveA, moveB));
+}
+
+SSearchResult CAnytimeSearch::search(const SSearchBudget& budget) {
+
+    // Time limit covers the whole call. Last part of it is kept for the lower bound.
+    auto start = std::chrono::steady_clock::now();
+    bool bDeadline = budget.timeLimit.count() > 0;
+    auto deadline = start + budget.timeLimit;
+    auto searchDeadline = start + budget.timeLimit - budget.timeLimit / 8;
+    size_t nodesAtStart = nodes;
+
+    while (!stack.empty()) {
+
+        // Check the budget, clock is read only once in a while.
+        if (budget.maxNodes && nodes - nodesAtStart >= budget.maxNodes) {
+            break;
+        }
+        if (bDeadline && (nodes & 0x3f) == 0 && std::chrono::steady_clock::now() >= searchDeadline) {
+            break;
+        }
+
+        SFrame& frame = stack.back();
+        if (!nextMove(frame)) {
+            stack.pop_back();
+            continue;
+        }
+        frame.bBoundExact = false;
+
+        SFrame child = { frame.left, !frame.bForward, frame.cost, frame.nextA, frame.nextB, -1, -1, 0, false };
+        double legCost = times[frame.nextA];
+        child.left ^= uint64_t(1) << frame.nextA;
+        if (frame.nextB >= 0) {
+            legCost = std::max(legCost, times[frame.nextB]);
+            child.left ^= uint64_t(1) << frame.nextB;
+        }
+        child.cost += legCost;
+        ++nodes;
+
+        // Everyone crossed
+        if (child.left == 0) {
+            if (child.cost < bestCost) {
+                recordBest(child.cost, child.moveA, child.moveB);
+            }
+            continue;
+        }
+        // prune if it can't beat the best schedule found so far
+        child.bound = child.cost + lowerBoundToCross(child.left, child.bForward);
+        if (child.bound >= bestCost) {
+            continue;
+        }
+        // prune if the same state was already reached in no more time. Schedules
+        // from there are explored, or are still under the moves not yet tried.
+        if (!isFirstVisit(child.left, child.bForward, child.cost)) {
+            continue;
+        }
+        stack.push_back(child);
+    }
+
+    refineBounds(deadline, bDeadline);
+    return getResult();
+}
+
+SSearchResult CAnytimeSearch::getResult() const {
+
+    SSearchResult result;
+    result.bComplete = isComplete();
+    result.bestCost  = bestCost;
+    result.nodes     = nodes;
+
+    // Unexplored schedules are all under the moves not yet tried from the nodes on the stack.
+    result.lowerBound = bestCost;
+    for (auto& frame : stack) {
+        result.lowerBound = std::min(result.lowerBound, frame.bound);
+    }
+    result.gap = result.bComplete ? 0 : result.bestCost - result.lowerBound;
+
+    // Replay the best moves to describe the schedule
+    uint64_t left = all;
+    for (auto& move : bestMoves) {
+        std::stringstream ss;
+        if (left & (uint64_t(1) << move.first)) {
+            ss << hikers[move.first].name;
+            double legCost = times[move.first];
+            if (move.second >= 0) {
+                ss << ", " << hikers[move.second].name;
+                legCost = std::max(legCost, times[move.second]);
+                left ^= uint64_t(1) << move.second;
+            }
+            ss << " (" << legCost << ") -->";
+        }
+        else {
+            ss << "<-- " << hikers[move.first].name << " (" << times[move.first] << ")";
+        }
+        left ^= uint64_t(1) << move.first;
+        result.schedule.push_back(ss.str());
+    }
+    return result;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+// File: anytime.h
+//
+// Anytime variant of the exhaustive approach (Approach-2 of the hiking module)
+// for a single bridge. It runs within a time or node budget and returns the
+// best schedule found so far along with a proven lower bound of the optimal
+// time and the gap between them. The search can be resumed from where it
+// stopped by calling search() again with a new budget.
+//
+// Search is a depth first branch and bound over the same moves as the
+// exhaustive approach (two hikers go forward, one hiker comes back) with an
+// explicit stack, so that it can stop and resume at any node. Partial
+// schedules that can't beat the best one found so far are pruned using a
+// lower bound of the time still needed to cross, and so are the states
+// already reached in no more time.
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+#include "hiker.h"
+
+// Budget for one call of search(). Zero means no limit.
+struct SSearchBudget {
+    size_t                    maxNodes;   // Max nodes to expand in this call
+    std::chrono::microseconds timeLimit;  // Max wall clock time of this call, lower bound included
+
+    SSearchBudget();
+    SSearchBudget(size_t maxNodes, std::chrono::microseconds timeLimit);
+};
+
+// Outcome of the search so far.
+struct SSearchResult {
+    bool   bComplete;     // Search is over, best cost is the optimal time
+    double bestCost;      // Time of the best schedule found, infinity if none yet
+    double lowerBound;    // Proven lower bound of the optimal time
+    double gap;           // bestCost - lowerBound, zero when complete
+    size_t nodes;         // Total nodes expanded over all calls
+
+    std::vector<std::string> schedule;  // Moves of the best schedule
+};
+
+class CAnytimeSearch {
+
+public:
+    CAnytimeSearch(const std::vector<SHiker>& hikers, double bridgeLength);
+    ~CAnytimeSearch();
+
+    // Search (or resume the search) till it is complete or the budget is used.
+    SSearchResult search(const SSearchBudget& budget);
+
+    // Result as of the last call of search(), cheap to get.
+    SSearchResult getResult() const;
+    bool isComplete() const;
+
+    // Max hikers supported, hikers on each side are kept as a bitmask.
+    static const size_t maxHikers = 64;
+
+private:
+    // Node of the search with the cursor to its next child.
+    struct SFrame {
+        uint64_t left;      // Hikers on the left side of the bridge
+        bool     bForward;  // Torch is on the left side
+        double   cost;      // Time spent so far
+        int      moveA;     // Move that led to this node
+        int      moveB;     // -1 for a single hiker move
+        int      nextA;     // Cursor to the next move to try
+        int      nextB;
+        double   bound;       // Lower bound of the schedules under the moves not yet tried
+        bool     bBoundExact; // Bound is the min over the untried moves, not the whole node
+    };
+
+    CAnytimeSearch() = delete;
+
+    bool   nextMove(SFrame& frame) const;
+    double lowerBoundToCross(uint64_t left, bool bForward) const;
+    double sumOfSlowestInPairs(uint64_t left, double extra) const;
+    double lowerBoundOfUntriedMoves(const SFrame& frame, std::chrono::steady_clock::time_point deadline,
+                                    bool bDeadline) const;
+    void   refineBounds(std::chrono::steady_clock::time_point deadline, bool bDeadline);
+    bool   isFirstVisit(uint64_t left, bool bForward, double cost);
+    void   seedBest();
+    void   recordBest(double cost, int moveA, int moveB);
+
+    std::vector<SHiker> hikers;  // Sorted from fastest to slowest
+    std::vector<double> times;   // Time for each hiker to cross alone
+    uint64_t            all;
+    double              minTime;
+
+    std::vector<SFrame> stack;
+
+    // Least time each state (hikers on the left, side of the torch) is reached
+    // in so far, indexed by bForward. Bounded to keep the memory in check.
+    std::unordered_map<uint64_t, double> visited[2];
+    static const size_t maxVisitedStates = 1 << 20;
+
+    double              bestCost;
+    std::vector<std::pair<int, int>> bestMoves;
+    size_t              nodes;
+};
@@ -24,8 +24,10 @@
 #include <vector>
 #include <sstream>
 #include <cassert>
+#include <cmath>
 
 #include "config.h"
+#include "profile.h"
 
 CConfig::CConfig(const std::string& file) {
     this->file = file;
@@ -67,89 +69,118 @@ void CConfig::readConfigAndTriggerEvents(CHiking& hiking) {
 
         }
         if (fileStream.is_open()) {
+            readEventsAndTriggerEvents(fileStream, hiking, &std::cerr);
+            fileStream.close();
+        }
+        else {
+            std::cerr << "Unable to open the file: " << file << ", check the permission to access." << std::endl;
+        }
+    }
+    else {
+        std::cerr << "Invalid config file." << std::endl;
+    }
+}
 
-            SHiker  hiker;
-            SBridge bridge;
+// Parse the events from the stream and trigger events to cross the bridge.
+// The stream need not be a file, events can be passed from memory as well.
+// Invalid events are skipped and reported to errors (if any), returns their count.
+size_t CConfig::readEventsAndTriggerEvents(std::istream& events, CHiking& hiking, std::ostream* errors) {
 
-            enum EType {
-                NONE = 0,
-                HIKER = 1,
-                BRIDGE = 2,
-            } eType(NONE);
+    CProfileScope profileScope(PROFILE_PARSER);
 
-            while (fileStream) {
-                std::string line;
-                getline(fileStream, line);
+    size_t numErrors = 0;
+    auto reportError = [&numErrors, errors](const char* message) {
+        ++numErrors;
+        if (errors) {
+            *errors << message << std::endl;
+        }
+    };
 
-                // Erase the comment
-                removeComment(line);
+    SHiker  hiker;
+    SBridge bridge;
 
-                std::vector<std::string> tokens;
-                getTokens(line, tokens);
+    enum EType {
+        NONE = 0,
+        HIKER = 1,
+        BRIDGE = 2,
+    } eType(NONE);
 
-                if (tokens.size()) {
-                    if (tokens[0] == "hikers") {
-                        eType = HIKER;
-                        bridge.clear();
-                        continue;
-                    }
-                    else if (tokens[0] == "bridge") {
-                        eType = BRIDGE;
-                        hiker.clear();
-                        continue;
-                    }
-                }
+    while (events) {
+        std::string line;
+        getline(events, line);
 
-                if (tokens.size() == 2) {
-                    switch (eType) {
-                    case HIKER:
-                        if (tokens[0] == "name") {
-                            hiker.name = tokens[1];
+        // Erase the comment
+        removeComment(line);
+
+        std::vector<std::string> tokens;
+        getTokens(line, tokens);
+
+        if (tokens.size()) {
+            if (tokens[0] == "hikers") {
+                eType = HIKER;
+                bridge.clear();
+                continue;
+            }
+            else if (tokens[0] == "bridge") {
+                eType = BRIDGE;
+                hiker.clear();
+                continue;
+            }
+        }
+
+        if (tokens.size() == 2) {
+            switch (eType) {
+            case HIKER:
+                if (tokens[0] == "name") {
+                    hiker.name = tokens[1];
+                }
+                else if (tokens[0] == "speed") {
+                    try {
+                        hiker.speed = std::stod(tokens[1]);
+                        if (std::isfinite(hiker.speed) && hiker.speed > 0) {
+                            hiking.addHiker(hiker);
                         }
-                        else if (tokens[0] == "speed") {
-                            try {
-                                hiker.speed = std::stod(tokens[1]);
-                                hiking.addHiker(hiker);
-                            }
-                            catch (std::invalid_argument& ex) {
-                                std::cerr << "Invalid input for speed, unable to convert to double." << std::endl;
-                            }
-                            catch (std::out_of_range& ex) {
-                                std::cerr << "Value is out of the range for speed." << std::endl;
-                            }
+                        else {
+                            reportError("Invalid input for speed, it must be greater than zero.");
                         }
-                        break;
-                    case BRIDGE:
-                        if (tokens[0] == "name") {
-                            bridge.name = tokens[1];
+                    }
+                    catch (std::invalid_argument& ex) {
+                        reportError("Invalid input for speed, unable to convert to double.");
+                    }
+                    catch (std::out_of_range& ex) {
+                        reportError("Value is out of the range for speed.");
+                    }
+                }
+                break;
+            case BRIDGE:
+                if (tokens[0] == "name") {
+                    bridge.name = tokens[1];
+                }
+                else if (tokens[0] == "length") {
+                    try {
+                        bridge.length = std::stod(tokens[1]);
+                        if (std::isfinite(bridge.length) && bridge.length >= 0) {
+                            hiking.crossBridge(bridge);
                         }
-                        else if (tokens[0] == "length") {
-                            try {
-                                bridge.length = std::stod(tokens[1]);
-                                hiking.crossBridge(bridge);
-                            }
-                            catch (std::invalid_argument& ex) {
-                                std::cerr << "Invalid input for length, unable to convert to double." << std::endl;
-                            }
-                            catch (std::out_of_range& ex) {
-                                std::cerr << "Value is out of the range for length." << std::endl;
-                            }
+                        else {
+                            reportError("Invalid input for length, it must not be negative.");
                         }
-                        break;
-                    default:
-                        break;
+                    }
+                    catch (std::invalid_argument& ex) {
+                        reportError("Invalid input for length, unable to convert to double.");
+                    }
+                    catch (std::out_of_range& ex) {
+                        reportError("Value is out of the range for length.");
                     }
                 }
+                break;
+            default:
+                break;
             }
-            fileStream.close();
-        }
-        else {
-            std::cerr << "Unable to open the file: " << file << ", check the permission to access." << std::endl;
         }
     }
-    else {
-        std::cerr << "Invalid config file." << std::endl;
-    }
+    hiking.finishEvents();
+    return numErrors;
 }
 
 // Helper function to remove comments in config file
@@ -24,6 +24,8 @@
 
 #include <string>
 #include <fstream>
+#include <istream>
+#include <ostream>
 
 #include "hiking.h"
 
@@ -39,15 +41,20 @@ public:
     void clearFile();
     void readConfigAndTriggerEvents(CHiking& hiking);
 
+    // Parse events from any stream (e.g. events held in memory) and trigger them.
+    // Returns the number of invalid events, they are reported to errors if given.
+    static size_t readEventsAndTriggerEvents(std::istream& events, CHiking& hiking,
+                                             std::ostream* errors = nullptr);
+
 private:
     const std::string defaultConfig = "hiking_event_default.yaml";
 
     CConfig() = delete;
     void open();
     void close();
-    void removeComment(std::string& str);
-    void trimString(std::string& str);
-    void getTokens(std::string& line, std::vector<std::string>& tokens);
+    static void removeComment(std::string& str);
+    static void trimString(std::string& str);
+    static void getTokens(std::string& line, std::vector<std::string>& tokens);
 
     std::string file;
     std::ifstream fileStream;
@@ -0,0 +1,132 @@
+// File: hikeapi.cpp
+//
+// C interface of the hiking solver. Thin wrapper over CConfig and CHiking,
+// no exception is allowed to cross the interface and nothing is printed.
+
+#include <streambuf>
+#include <cmath>
+#include <limits>
+
+#include "hikeapi.h"
+#include "hiking.h"
+#include "config.h"
+
+namespace {
+
+// Stream buffer over the caller memory, so that the events are parsed
+// without copying them into a string first.
+struct SMemoryBuf : std::streambuf {
+    SMemoryBuf(const char* data, size_t length) {
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + length);
+    }
+};
+
+bool isValidComputeType(int computeType) {
+    return computeType == HIKE_COMPUTE_OPTIMIZED || computeType == HIKE_COMPUTE_ALL_COMBINATIONS
+        || computeType == HIKE_COMPUTE_OPTIMIZED_PARALLEL;
+}
+
+bool isValidGroup(const hike_group& group, int computeType) {
+    if ((group.numHikers && !group.speeds) || (group.numBridges && !group.bridgeLengths)) {
+        return false;
+    }
+    // Bridge can't be crossed without any hiker
+    if (group.numBridges && !group.numHikers) {
+        return false;
+    }
+    if (computeType == HIKE_COMPUTE_ALL_COMBINATIONS && group.numBridges
+        && group.numHikers > HIKE_MAX_ALL_COMBINATIONS_HIKERS) {
+        return false;
+    }
+    for (size_t i = 0; i < group.numHikers; ++i) {
+        if (!std::isfinite(group.speeds[i]) || group.speeds[i] <= 0) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < group.numBridges; ++i) {
+        if (!std::isfinite(group.bridgeLengths[i]) || group.bridgeLengths[i] < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int hike_api_version(void) {
+    return HIKE_API_VERSION;
+}
+
+int hike_solve_events(const char* events, size_t length, int computeType, double* hikeTime) {
+
+    if ((length && !events) || !hikeTime || !isValidComputeType(computeType)) {
+        return HIKE_ERR_INVALID_ARG;
+    }
+
+    try {
+        CHiking hiking;
+        hiking.setComputeType(static_cast<CHiking::eComputeType>(computeType));
+        hiking.setMaxExhaustiveHikers(HIKE_MAX_ALL_COMBINATIONS_HIKERS);
+
+        SMemoryBuf buf(events, length);
+        std::istream stream(&buf);
+        size_t numErrors = CConfig::readEventsAndTriggerEvents(stream, hiking);
+
+        if (numErrors || hiking.getRejectedBridges()) {
+            *hikeTime = std::numeric_limits<double>::quiet_NaN();
+            return HIKE_ERR_INVALID_ARG;
+        }
+        *hikeTime = hiking.getHikeTime();
+    }
+    catch (...) {
+        return HIKE_ERR_INTERNAL;
+    }
+    return HIKE_OK;
+}
+
+int hike_solve_batch(const hike_group* groups, size_t numGroups, int computeType, double* hikeTimes) {
+
+    if (numGroups && (!groups || !hikeTimes)) {
+        return HIKE_ERR_INVALID_ARG;
+    }
+    if (!isValidComputeType(computeType)) {
+        return HIKE_ERR_INVALID_ARG;
+    }
+
+    int status = HIKE_OK;
+    try {
+        // Same hiking object is reused for all the groups to avoid per group setup.
+        CHiking hiking;
+        hiking.setComputeType(static_cast<CHiking::eComputeType>(computeType));
+
+        SHiker  hiker;
+        SBridge bridge;
+
+        for (size_t g = 0; g < numGroups; ++g) {
+            const hike_group& group = groups[g];
+
+            if (!isValidGroup(group, computeType)) {
+                hikeTimes[g] = std::numeric_limits<double>::quiet_NaN();
+                status = HIKE_ERR_INVALID_ARG;
+                continue;
+            }
+
+            hiking.clear();
+            for (size_t i = 0; i < group.numHikers; ++i) {
+                hiker.speed = group.speeds[i];
+                hiking.addHiker(hiker);
+            }
+            for (size_t i = 0; i < group.numBridges; ++i) {
+                bridge.length = group.bridgeLengths[i];
+                hiking.crossBridge(bridge);
+            }
+            hiking.finishEvents();
+            hikeTimes[g] = hiking.getHikeTime();
+        }
+    }
+    catch (...) {
+        return HIKE_ERR_INTERNAL;
+    }
+    return status;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+// File: hikeapi.h
+//
+// C interface of the hiking solver. It lets other processes embed the config
+// parser and the hiking module as a library (libhike.a / libhike.so) instead
+// of spawning the hike binary and writing yaml files on disk.
+//
+// Events can be passed directly from memory in the same yaml format as the
+// config files. For the request path, the batch call solves many independent
+// groups in one call and writes the results into caller provided buffers.
+//
+// Example:
+//      double speeds[]  = { 100, 50, 20, 10 };
+//      double bridges[] = { 100, 250 };
+//      hike_group group = { speeds, 4, bridges, 2 };
+//      double hikeTime;
+//      hike_solve_batch(&group, 1, HIKE_COMPUTE_OPTIMIZED, &hikeTime);
+//
+
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(HIKE_BUILD_DLL)
+#define HIKE_API __declspec(dllexport)
+#elif defined(__GNUC__)
+#define HIKE_API __attribute__((visibility("default")))
+#else
+#define HIKE_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Version of this interface, bumped on incompatible changes.
+#define HIKE_API_VERSION 1
+
+// Return codes
+#define HIKE_OK                0
+#define HIKE_ERR_INVALID_ARG  -1   // Bad pointer, count, speed or length
+#define HIKE_ERR_INTERNAL     -2   // Unexpected failure inside the solver
+
+// Compute types, same values as CHiking::eComputeType
+#define HIKE_COMPUTE_OPTIMIZED         1
+#define HIKE_COMPUTE_ALL_COMBINATIONS  2
+#define HIKE_COMPUTE_OPTIMIZED_PARALLEL 3
+
+// HIKE_COMPUTE_ALL_COMBINATIONS enumerates every schedule, which grows
+// factorially with the group (6 hikers take seconds). Larger groups at
+// a bridge are rejected with HIKE_ERR_INVALID_ARG.
+#define HIKE_MAX_ALL_COMBINATIONS_HIKERS 5
+
+// An independent group of hikers crossing the given bridges in order.
+// Bridges can't be crossed without hikers, so a group with bridges and no
+// hikers is invalid (same as a bridge before any hiker in the events).
+typedef struct hike_group {
+    const double* speeds;          // Speed of each hiker in feets/min, must be > 0
+    size_t        numHikers;
+    const double* bridgeLengths;   // Length of each bridge in feets, must be >= 0
+    size_t        numBridges;
+} hike_group;
+
+// Get the version of the interface the library was built with.
+HIKE_API int hike_api_version(void);
+
+// Parse the events (yaml text, not necessarily null terminated) and get
+// the total time to cross all bridges in hikeTime. Any invalid event (e.g.
+// speed not > 0, or a bridge before any hiker joined) fails with
+// HIKE_ERR_INVALID_ARG and NaN time.
+HIKE_API int hike_solve_events(const char* events, size_t length, int computeType, double* hikeTime);
+
+// Solve numGroups independent groups. hikeTimes must have room for numGroups
+// results. An invalid group gets NaN as its time and HIKE_ERR_INVALID_ARG is
+// returned after the remaining groups are solved.
+HIKE_API int hike_solve_batch(const hike_group* groups, size_t numGroups, int computeType, double* hikeTimes);
+
+#ifdef __cplusplus
+}
+#endif
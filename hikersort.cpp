@@ -0,0 +1,162 @@
+// File: hikersort.cpp
+//
+// LSD radix sort of the hikers on the speed and linear merge of a sorted
+// batch into the sorted group.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <thread>
+
+#include "hikersort.h"
+#include "solverutil.h"
+
+namespace {
+
+// Smaller batches are sorted by comparison, larger ones are sorted by threads.
+const size_t minRadixSort    = 256;
+const size_t minParallelSort = 1 << 16;
+
+struct SKey {
+    uint64_t key;
+    uint32_t index;
+};
+
+// Key of the speed that sorts in ascending order from the fastest hiker.
+// Bits of a double sort like integers once the sign bit is flipped for
+// positive values and all bits are flipped for negative values.
+uint64_t speedKey(double speed) {
+    uint64_t bits;
+    std::memcpy(&bits, &speed, sizeof(bits));
+    bits = (bits & 0x8000000000000000ULL) ? ~bits : (bits | 0x8000000000000000ULL);
+    return ~bits;
+}
+
+// Stable sort on the keys, one byte per pass. Each thread counts and scatters
+// its own chunk, chunks are placed in order so the sort stays stable. Passes
+// where all keys have the same byte are skipped.
+void radixSortKeys(std::vector<SKey>& keys, unsigned threads) {
+
+    size_t n = keys.size();
+    size_t numChunks = (n >= minParallelSort) ? threads : 1;
+    size_t chunkSize = (n + numChunks - 1) / numChunks;
+
+    std::vector<SKey> buffer(n);
+    std::vector<std::array<size_t, 256>> counts(numChunks);
+
+    auto forEachChunk = [&](const std::function<void(size_t, size_t, size_t)>& work) {
+        std::vector<std::thread> workers;
+        for (size_t c = 1; c < numChunks; ++c) {
+            workers.push_back(std::thread(work, c, std::min(n, c * chunkSize), std::min(n, (c + 1) * chunkSize)));
+        }
+        work(0, 0, std::min(n, chunkSize));
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    };
+
+    for (int shift = 0; shift < 64; shift += 8) {
+
+        forEachChunk([&](size_t c, size_t first, size_t last) {
+            counts[c].fill(0);
+            for (size_t i = first; i < last; ++i) {
+                ++counts[c][(keys[i].key >> shift) & 0xff];
+            }
+        });
+
+        // Turn counts into the positions of each chunk in the output
+        size_t offset = 0;
+        bool bSameByte = false;
+        for (size_t d = 0; d < 256; ++d) {
+            size_t start = offset;
+            for (size_t c = 0; c < numChunks; ++c) {
+                size_t count = counts[c][d];
+                counts[c][d] = offset;
+                offset += count;
+            }
+            bSameByte = bSameByte || (offset - start == n);
+        }
+        if (bSameByte) {
+            continue;
+        }
+
+        forEachChunk([&](size_t c, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                buffer[counts[c][(keys[i].key >> shift) & 0xff]++] = keys[i];
+            }
+        });
+        keys.swap(buffer);
+    }
+}
+
+// Keys of the first numHikers hikers in the sorted order.
+void sortedKeys(const std::vector<SHiker>& hikers, size_t numHikers, unsigned threads, std::vector<SKey>& keys) {
+
+    if (!threads) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    keys.resize(numHikers);
+    for (size_t i = 0; i < numHikers; ++i) {
+        keys[i].key   = speedKey(hikers[i].speed);
+        keys[i].index = static_cast<uint32_t>(i);
+    }
+    radixSortKeys(keys, threads);
+}
+
+} // namespace
+
+void sortHikersBySpeed(std::vector<SHiker>& hikers, unsigned threads) {
+
+    if (hikers.size() < minRadixSort) {
+        std::stable_sort(hikers.begin(), hikers.end(), bySpeed);
+        return;
+    }
+
+    std::vector<SKey> keys;
+    sortedKeys(hikers, hikers.size(), threads, keys);
+
+    std::vector<SHiker> sorted;
+    sorted.reserve(hikers.size());
+    for (auto& key : keys) {
+        sorted.push_back(std::move(hikers[key.index]));
+    }
+    hikers.swap(sorted);
+}
+
+void mergeHikersBySpeed(std::vector<SHiker>& group, std::vector<SHiker>& batch, unsigned threads) {
+
+    if (batch.empty()) {
+        return;
+    }
+    sortHikersBySpeed(batch, threads);
+
+    size_t mid = group.size();
+    group.insert(group.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+    batch.clear();
+
+    std::inplace_merge(group.begin(), group.begin() + mid, group.end(), bySpeed);
+}
+
+void orderHikersBySpeed(const std::vector<SHiker>& hikers, size_t numHikers, std::vector<size_t>& order, unsigned threads) {
+
+    order.resize(numHikers);
+
+    if (numHikers < minRadixSort) {
+        for (size_t i = 0; i < numHikers; ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&hikers](size_t a, size_t b) { return bySpeed(hikers[a], hikers[b]); });
+        return;
+    }
+
+    std::vector<SKey> keys;
+    sortedKeys(hikers, numHikers, threads, keys);
+    for (size_t i = 0; i < numHikers; ++i) {
+        order[i] = keys[i].index;
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// File: hikersort.h
+//
+// Sorting of the hikers from the fastest to the slowest, the order used by
+// the optimized approach.
+//
+// Batch of joining hikers is sorted with an LSD radix sort on the speed, in
+// parallel for large batches, and merged in linear time into the group that
+// is already sorted. So the group never needs to be sorted as a whole again.
+
+#include <vector>
+
+#include "hiker.h"
+
+// Stable sort from the fastest to the slowest hiker.
+// threads: number of threads to use for large batches, 0 to use all cores.
+void sortHikersBySpeed(std::vector<SHiker>& hikers, unsigned threads);
+
+// Sort the batch and merge it into the sorted group. Batch is left empty.
+// Hikers already in the group come first among the ones with the same speed.
+void mergeHikersBySpeed(std::vector<SHiker>& group, std::vector<SHiker>& batch, unsigned threads);
+
+// Order of the first numHikers hikers from the fastest to the slowest (stable),
+// as their indexes. Hikers are left as they are.
+void orderHikersBySpeed(const std::vector<SHiker>& hikers, size_t numHikers, std::vector<size_t>& order, unsigned threads);
@@ -9,13 +9,47 @@
 #include <sstream>
 #include <climits>
 #include <cassert>
+#include <thread>
+#include <functional>
+#include <iterator>
+#include <exception>
 
 #include "hiking.h"
 #include "debug.h"
+#include "verifier.h"
+#include "schedules.h"
+#include "hikersort.h"
+#include "profile.h"
 
+namespace {
 
-CHiking::CHiking() : totalTimeToCross(0), computeType(OPTIMIZED),
-                     minCostToMove(INT_MAX), iterations(0)
+// Speed of a hiker, for the computations working on the speeds alone.
+inline double speedOf(const SHiker& hiker) {
+    return hiker.speed;
+}
+
+inline double speedOf(double speed) {
+    return speed;
+}
+
+// Joins the threads started so far when going out of scope, so that a failure
+// part way through never destroys a joinable thread (std::terminate).
+struct SThreadJoiner {
+    std::vector<std::thread>& threads;
+
+    ~SThreadJoiner() {
+        for (auto& thread : threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+};
+
+} // namespace
+
+CHiking::CHiking() : totalTimeToCross(0), computeType(OPTIMIZED), verifier(nullptr), threads(0),
+                     minCostToMove(INT_MAX), iterations(0), maxExhaustiveHikers(0), rejectedBridges(0)
 {
 }
 
@@ -25,6 +59,10 @@ CHiking::~CHiking() {
 void CHiking::clear() {
     totalTimeToCross = 0;
     hikers.clear();
+    joiningHikers.clear();
+    recordedBridges.clear();
+    recordedGroupSizes.clear();
+    rejectedBridges = 0;
 }
 
 double CHiking::getHikeTime() const {
@@ -35,13 +73,57 @@ void CHiking::setComputeType(eComputeType type) {
     computeType = type;
 }
 
+void CHiking::setThreads(unsigned threads) {
+    this->threads = threads;
+}
+
+void CHiking::setVerifier(CVerifier* verifier) {
+    this->verifier = verifier;
+}
+
+void CHiking::setMaxExhaustiveHikers(size_t maxHikers) {
+    maxExhaustiveHikers = maxHikers;
+}
+
+size_t CHiking::getRejectedBridges() const {
+    return rejectedBridges;
+}
+
 // Add hiker to the hiker group. Whenever bridge is encountered
 // at that time, cross bridge function is executed.
 void CHiking::addHiker(const SHiker& hiker) {
     if (bIsDebug(DEBUG_TRACE)) {
         std::cout << "ADD:   " << "Hiker: " << hiker.name << ", Speed: " << hiker.speed << " feet/minute" << std::endl;
     }
-    hikers.push_back(hiker);
+    joiningHikers.push_back(hiker);
+}
+
+// Add a batch of hikers joining the group at once.
+void CHiking::addHikers(const std::vector<SHiker>& hikers) {
+    if (bIsDebug(DEBUG_TRACE)) {
+        for (auto& hiker : hikers) {
+            std::cout << "ADD:   " << "Hiker: " << hiker.name << ", Speed: " << hiker.speed << " feet/minute" << std::endl;
+        }
+    }
+    joiningHikers.insert(joiningHikers.end(), hikers.begin(), hikers.end());
+}
+
+// Hikers joined since the last bridge are sorted as a batch (radix sort) and
+// merged into the already sorted group in linear time, rather than sorting
+// the whole group again at every bridge.
+void CHiking::mergeJoiningHikers() {
+    if (joiningHikers.empty()) {
+        return;
+    }
+    if (computeType == OPTIMIZED_PARALLEL) {
+        // Groups at the bridges are taken from the order of joining
+        hikers.insert(hikers.end(), std::make_move_iterator(joiningHikers.begin()),
+                      std::make_move_iterator(joiningHikers.end()));
+        joiningHikers.clear();
+    }
+    else {
+        mergeHikersBySpeed(hikers, joiningHikers, threads);
+    }
 }
 
 // Whenever bridge is encounterd, cross bridge functrion is executed.
@@ -50,11 +132,42 @@ void CHiking::crossBridge(const SBridge& bridge) {
     if (bIsDebug(DEBUG_TRACE)) {
         std::cout << "CROSS: " << "Bridge: " << bridge.name << ", Length: " << bridge.length << " feet" << std::endl;
     }
+    CProfileScope profileScope(computeType == ALL_COMBINATIONS ? PROFILE_EXHAUSTIVE : PROFILE_OPTIMIZED);
+
+    mergeJoiningHikers();
+
+    // Nobody to cross the bridge
+    if (hikers.empty()) {
+        ++rejectedBridges;
+        return;
+    }
+
     if (computeType == OPTIMIZED) {
         crossBridgeOptimized(bridge);
     }
     else if (computeType == ALL_COMBINATIONS) {
-        crossBridgeBruteForce(bridge);
+        if (maxExhaustiveHikers && hikers.size() > maxExhaustiveHikers) {
+            ++rejectedBridges;
+        }
+        else {
+            crossBridgeBruteForce(bridge);
+        }
+    }
+    else if (computeType == OPTIMIZED_PARALLEL) {
+        recordedBridges.push_back(bridge);
+        recordedGroupSizes.push_back(hikers.size());
+    }
+}
+
+// At the end of events, bridges recorded so far are evaluated.
+// Total hike time is up to date only after this.
+void CHiking::finishEvents() {
+    CProfileScope profileScope(computeType == ALL_COMBINATIONS ? PROFILE_EXHAUSTIVE : PROFILE_OPTIMIZED);
+
+    mergeJoiningHikers();
+
+    if (recordedBridges.size()) {
+        crossBridgeOptimizedParallel();
     }
 }
 
@@ -89,14 +202,16 @@ void CHiking::crossBridge(const SBridge& bridge) {
 //
 
 double CHiking::crossBridgeOptimized(const SBridge& bridge) {
-    // Sort the hikers for the optimized technquie.
-    std::sort(hikers.begin(), hikers.end());
-
+    // Hikers are already sorted for the optimized technquie as they join.
     printHikers();
 
     double timeToCross = crossBridgeOptimizedCompute(hikers, hikers.size(), bridge.length);
     totalTimeToCross += timeToCross;
 
+    if (verifier) {
+        verifier->submit(hikers, bridge.length, timeToCross);
+    }
+
     if (bIsDebug(DEBUG_INTER)) {
         std::cout << "Approach-1: Time to cross bridge " << bridge.name << ": " << timeToCross << std::endl;
         std::cout << "Approach-1: Total Time to cross: " << totalTimeToCross << std::endl;
@@ -105,29 +220,189 @@ double CHiking::crossBridgeOptimized(const SBridge& bridge) {
     return totalTimeToCross;
 }
 
-double CHiking::crossBridgeOptimizedCompute(std::vector<SHiker>&hikers, size_t numHikers, double bridgeLength) {
+// Parallel evaluation of the optimized approach.
+// Group at each bridge is the first hikers up to the recorded group size, as
+// hikers only join. All hikers are sorted once, each one tagged with the bridge
+// it joined at, so the group at any bridge is the sorted hikers that joined up
+// to that bridge. Bridges are split into ranges of about the same work, one per
+// thread. Each thread takes the speeds at the first bridge of its range in one
+// pass over the sorted hikers and merges in the ones joining after that.
+// Times are added in the order of the bridges at the end, so the total is
+// exactly the same as crossing the bridges one after the other.
+void CHiking::crossBridgeOptimizedParallel() {
+
+    size_t numBridges = recordedBridges.size();
+    std::vector<double> timesToCross(numBridges);
+
+    // Hikers joining after the last bridge don't cross any
+    size_t numHikers = recordedGroupSizes.back();
+    std::vector<size_t> joinedAt(numHikers);
+    for (size_t i = 0, h = 0; i < numBridges; ++i) {
+        for (; h < recordedGroupSizes[i]; ++h) {
+            joinedAt[h] = i;
+        }
+    }
+
+    std::vector<size_t> order;
+    orderHikersBySpeed(hikers, numHikers, order, threads);
+
+    std::vector<double> sortedSpeeds(numHikers);
+    std::vector<size_t> sortedJoinedAt(numHikers);
+    for (size_t i = 0; i < numHikers; ++i) {
+        sortedSpeeds[i]   = hikers[order[i]].speed;
+        sortedJoinedAt[i] = joinedAt[order[i]];
+    }
+
+    // Work for each bridge is about the size of the group, and each range
+    // takes a pass over all hikers to get its first group.
+    double bridgeWork = 0;
+    for (auto groupSize : recordedGroupSizes) {
+        bridgeWork += groupSize + 1;
+    }
+    double snapshotWork = static_cast<double>(numHikers) + 1;
+
+    // More ranges only pay off while each gets at least the work of its first group.
+    size_t numThreads = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    numThreads = std::min(numThreads, numBridges);
+    numThreads = std::max<size_t>(1, std::min<size_t>(numThreads, static_cast<size_t>(bridgeWork / snapshotWork)));
+    double totalWork = bridgeWork + numThreads * snapshotWork;
+
+    // Failure of a range is passed back to the caller once all threads are done.
+    std::vector<std::exception_ptr> errors(numThreads);
+    auto runRange = [&](size_t t, size_t first, size_t last) {
+        try {
+            crossBridgeOptimizedRange(sortedSpeeds, sortedJoinedAt, first, last, timesToCross);
+        }
+        catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    // Room for all, so that adding a started thread can't fail
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+    size_t first = 0;
+    double work = 0;
+
+    // Threads are joined at the end of the block, also on a failure.
+    {
+        SThreadJoiner joiner = { workers };
+        for (size_t t = 0; t < numThreads && first < numBridges; ++t) {
+            size_t last = first;
+            double target = totalWork * (t + 1) / numThreads;
+            work += snapshotWork;
+            while (last < numBridges && (work < target || last == first || t + 1 == numThreads)) {
+                work += recordedGroupSizes[last] + 1;
+                ++last;
+            }
+            if (last == numBridges) {
+                runRange(t, first, last);
+            }
+            else {
+                workers.push_back(std::thread(runRange, t, first, last));
+            }
+            first = last;
+        }
+    }
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Reduce in the order of bridges
+    for (size_t i = 0; i < numBridges; ++i) {
+        totalTimeToCross += timesToCross[i];
+
+        if (bIsDebug(DEBUG_INTER)) {
+            std::cout << "Approach-1: Time to cross bridge " << recordedBridges[i].name << ": " << timesToCross[i] << std::endl;
+            std::cout << "Approach-1: Total Time to cross: " << totalTimeToCross << std::endl;
+        }
+    }
+    recordedBridges.clear();
+    recordedGroupSizes.clear();
+}
+
+// Evaluate the bridges [first, last) of the recorded bridges on the sorted
+// speeds of the hikers and the bridge each one joined at.
+void CHiking::crossBridgeOptimizedRange(const std::vector<double>& sortedSpeeds, const std::vector<size_t>& sortedJoinedAt,
+                                        size_t first, size_t last, std::vector<double>& timesToCross) const {
+
+    CProfileScope profileScope(PROFILE_OPTIMIZED);
+
+    // Group at the first bridge, and the hikers joining at each of the other
+    // bridges of the range, all in the sorted order.
+    std::vector<double> group;
+    std::vector<std::vector<double>> joining(last - first);
+    group.reserve(recordedGroupSizes[first]);
+    for (size_t i = 0; i < sortedSpeeds.size(); ++i) {
+        size_t bridge = sortedJoinedAt[i];
+        if (bridge <= first) {
+            group.push_back(sortedSpeeds[i]);
+        }
+        else if (bridge < last) {
+            joining[bridge - first].push_back(sortedSpeeds[i]);
+        }
+    }
 
-    // For one or two hikers, it will be the time required for the slowest hiker
-    if (numHikers < 3) {
-        return bridgeLength / hikers[1].speed;
+    std::vector<double> merged;
+    for (size_t i = first; i < last; ++i) {
+        auto& batch = joining[i - first];
+        if (batch.size()) {
+            merged.resize(group.size() + batch.size());
+            std::merge(group.begin(), group.end(), batch.begin(), batch.end(), merged.begin(), std::greater<double>());
+            group.swap(merged);
+            std::vector<double>().swap(batch);
+        }
+
+        timesToCross[i] = crossBridgeOptimizedCompute(group, group.size(), recordedBridges[i].length);
+
+        if (verifier) {
+            verifier->submit(group, recordedBridges[i].length, timesToCross[i]);
+        }
+    }
+}
+
+// Two slowest hikers get across in each step till three or less are left.
+// Time for the hikers left at the end is computed first and the steps are
+// added back from the last one, so that the sum is the same as adding them
+// up recursively, without going deep in the stack for large groups.
+template <typename THiker>
+double CHiking::crossBridgeOptimizedCompute(const std::vector<THiker>& hikers, size_t numHikers, double bridgeLength) {
+
+    size_t numLeft = numHikers < 4 ? numHikers : 2 + numHikers % 2;
+    double time = 0;
+
+    // Nobody to cross the bridge
+    if (numLeft == 0) {
+        time = 0;
+    }
+    // Single hiker crosses alone
+    else if (numLeft == 1) {
+        time = bridgeLength / speedOf(hikers[0]);
+    }
+    // For two hikers, it will be the time required for the slowest hiker
+    else if (numLeft == 2) {
+        time = bridgeLength / speedOf(hikers[1]);
     }
     // For three hikers, it will be the time required for all hikers
-    else if (numHikers == 3) {
-        return bridgeLength / hikers[0].speed
-            + bridgeLength / hikers[1].speed
-            + bridgeLength / hikers[2].speed;
+    else {
+        time = bridgeLength / speedOf(hikers[0])
+            + bridgeLength / speedOf(hikers[1])
+            + bridgeLength / speedOf(hikers[2]);
     }
+
     // If four or more hikers, compute based on the optimized cases
-    else {
-        double timeForCase1 = bridgeLength / hikers[1].speed + bridgeLength / hikers[0].speed
-            + bridgeLength / hikers[numHikers - 1].speed + bridgeLength / hikers[1].speed;
-        double timeForCase2 = bridgeLength / hikers[numHikers - 1].speed + bridgeLength / hikers[0].speed
-            + bridgeLength / hikers[numHikers - 2].speed + bridgeLength / hikers[0].speed;
+    for (size_t n = numLeft + 2; n <= numHikers; n += 2) {
+        double timeForCase1 = bridgeLength / speedOf(hikers[1]) + bridgeLength / speedOf(hikers[0])
+            + bridgeLength / speedOf(hikers[n - 1]) + bridgeLength / speedOf(hikers[1]);
+        double timeForCase2 = bridgeLength / speedOf(hikers[n - 1]) + bridgeLength / speedOf(hikers[0])
+            + bridgeLength / speedOf(hikers[n - 2]) + bridgeLength / speedOf(hikers[0]);
         double minTime = std::min(timeForCase1, timeForCase2);
 
-        // Compute for remaining hikers
-        return minTime + crossBridgeOptimizedCompute(hikers, numHikers - 2, bridgeLength);
+        time = minTime + time;
     }
+    return time;
 }
 
 
@@ -146,6 +421,7 @@ double CHiking::crossBridgeBruteForce(const SBridge& bridge) {
     std::string moveLog;
     minCostToMove = INT_MAX;
     iterations = 0;
+    leastCostMoveLog.clear();
 
     printHikers();
 
@@ -155,8 +431,24 @@ double CHiking::crossBridgeBruteForce(const SBridge& bridge) {
 
     if (bIsDebug(DEBUG_STEPS)) {
         std::cout << "Approach-2: Total iterations: " << iterations << std::endl;
-        for (auto leastCostMoveLog : leastCostMoveLogs) {
-            std::cout << leastCostMoveLog << std::endl;
+        std::cout << leastCostMoveLog << std::endl;
+
+        // Count of the optimal schedules and the first few of them, as there
+        // can be far too many to print (e.g. billions for 8 hikers of the same speed).
+        if (hikers.size() <= COptimalSchedules::maxHikers) {
+            COptimalSchedules schedules(hikers, bridge.length);
+            std::cout << "Approach-2: Optimal schedules: " << schedules.getCount()
+                      << (schedules.isCountSaturated() ? " (saturated)" : "") << std::endl;
+
+            const size_t maxSchedulesToPrint = 8;
+            COptimalSchedules::CIterator it(schedules);
+            std::vector<std::string> schedule;
+            for (size_t printed = 0; printed < maxSchedulesToPrint && it.next(schedule); ++printed) {
+                for (auto& move : schedule) {
+                    std::cout << "     " << move << std::endl;
+                }
+                std::cout << std::endl;
+            }
         }
     }
 
@@ -179,10 +471,7 @@ void CHiking::crossBridgeBruteForceCompute(std::vector<SHiker> left, std::vector
 
         if (minCostToMove > cost) {
             minCostToMove = cost;
-            leastCostMoveLogs.clear();
-        }
-        if (minCostToMove == cost) {
-            leastCostMoveLogs.push_back(moveLog);
+            leastCostMoveLog = moveLog;
         }
         return;
     }
@@ -200,6 +489,21 @@ void CHiking::crossBridgeBruteForceCompute(std::vector<SHiker> left, std::vector
         // update the left and right accordingly.
         // Here get all combination of the pairs to cross the bridge (left to right)
 
+        // Lone hiker in the group crosses alone.
+        if (left.size() == 1) {
+            double legCost = bridgeLength / left[0].speed;
+
+            std::stringstream ss;
+            ss << moveLog << "    " << left[0].name << " -- " << left[0].name << " (" << (legCost) << ") --> ";
+            for (auto hiker : right) { ss << " " << hiker.name; }
+            ss << " " << left[0].name << ", currentCost: " << cost + legCost << std::endl;
+
+            std::vector<SHiker> rightUpdated = right;
+            rightUpdated.push_back(left[0]);
+            crossBridgeBruteForceCompute(std::vector<SHiker>(), rightUpdated, RIGHT_TO_LEFT, cost + legCost, bridgeLength, ss.str());
+            break;
+        }
+
         for (int i = 0; i < left.size() - 1; ++i) {
             for (int j = i + 1; j < left.size(); ++j) {
                 double legCost = std::max(bridgeLength / left[i].speed, bridgeLength / left[j].speed);
@@ -266,4 +570,4 @@ void CHiking::printHikers() {
         }
         std::cout << std::endl;
     }
-}
+}
@@ -12,6 +12,7 @@
 #include "hiker.h"
 #include "bridge.h"
 
+class CVerifier;
 
 class CHiking {
 
@@ -20,33 +21,70 @@ public:
     ~CHiking();
 
     void   addHiker(const SHiker& hiker);       // Add hiker
+    void   addHikers(const std::vector<SHiker>& hikers);  // Add a batch of hikers joining at once
     void   crossBridge(const SBridge& bridge);  // Cross the bridge
+    void   finishEvents();                      // End of events, evaluate the recorded ones
     void   clear();                             // clear internal states
     double getHikeTime() const;                 // Get the total hike time
 
     enum eComputeType {
-        OPTIMIZED        = 1,  // Compute only for the optimized cases
-        ALL_COMBINATIONS = 2,  // Enumerate all cases and pick the best timw
+        OPTIMIZED          = 1,  // Compute only for the optimized cases
+        ALL_COMBINATIONS   = 2,  // Enumerate all cases and pick the best timw
+        OPTIMIZED_PARALLEL = 3,  // Record events and compute optimized cases on all cores at the end
     };
 
     // Set compute type to optimized algo or all_combination algo
     void  setComputeType(eComputeType type);
 
+    // Number of threads for OPTIMIZED_PARALLEL and for sorting large batches
+    // of joining hikers, 0 to use all cores.
+    void  setThreads(unsigned threads);
+
+    // Hand over the crossings of the optimized approach to the verifier
+    // to cross check in background. Pass nullptr to disable.
+    void  setVerifier(CVerifier* verifier);
+
+    // Largest group the ALL_COMBINATIONS approach is run for, 0 for no limit.
+    // Bridges with a larger group or with no hikers at all are not crossed,
+    // only counted as rejected.
+    void   setMaxExhaustiveHikers(size_t maxHikers);
+    size_t getRejectedBridges() const;
+
 
 private:
 
-    // All hikers at any given instance.
+    // All hikers at any given instance. Sorted from the fastest to the slowest,
+    // except for OPTIMIZED_PARALLEL where they are kept in the order of joining.
     std::vector<SHiker> hikers;
 
+    // Hikers joined since the last bridge. They are sorted as a batch and merged
+    // into the hikers when the next bridge is encountered.
+    std::vector<SHiker> joiningHikers;
+    void mergeJoiningHikers();
+
     // Total time taken by hikers to cross all bridges
     double totalTimeToCross;
 
     eComputeType computeType;
 
+    CVerifier* verifier;
+
     // ---------------- Approach-1 -----------------//
     // Optimized approach to compute the hike time
     double crossBridgeOptimized(const SBridge& bridge);
-    double crossBridgeOptimizedCompute(std::vector<SHiker>& hikers, size_t numHikers, double bridgeLength);
+
+    // Works on the hikers or on their speeds alone, both sorted from the fastest.
+    template <typename THiker>
+    static double crossBridgeOptimizedCompute(const std::vector<THiker>& hikers, size_t numHikers, double bridgeLength);
+
+    // Optimized approach evaluated in parallel. Bridges are recorded along with
+    // the group size at that time (hikers join in order) and evaluated at the end.
+    void   crossBridgeOptimizedParallel();
+    void   crossBridgeOptimizedRange(const std::vector<double>& sortedSpeeds, const std::vector<size_t>& sortedJoinedAt,
+                                     size_t first, size_t last, std::vector<double>& timesToCross) const;
+    std::vector<SBridge> recordedBridges;
+    std::vector<size_t>  recordedGroupSizes;
+    unsigned             threads;
 
 
     // ---------------- Approach-2 -----------------//
@@ -59,9 +97,11 @@ private:
     void   crossBridgeBruteForceCompute(std::vector<SHiker> left, std::vector<SHiker> right,
                                         DIRECTION dir, double cost, double bridgeLength, std::string moveLog);
     // helpers for Approach-2
-    std::vector<std::string> leastCostMoveLogs;
+    std::string leastCostMoveLog;  // First schedule found with the least cost, ties are not kept
     double minCostToMove;   // At the end of all iterations, this has the optimial cost/time to cross bridge
     int    iterations;
+    size_t maxExhaustiveHikers;
+    size_t rejectedBridges;
 
     // Utility function to print hikers.
     void printHikers();
@@ -21,15 +21,19 @@
 #include <cassert>
 #include <sstream>
 #include <chrono>
+#include <cstdlib>
 
 #include "hiking.h"
 #include "config.h"
 #include "debug.h"
+#include "verifier.h"
+#include "profile.h"
 
 // Trigger computation using the optimal approach
-double crossBridgeOptimizedApproach(const std::string& configFile) {
+double crossBridgeOptimizedApproach(const std::string& configFile, CVerifier* verifier = nullptr, bool bParallel = false) {
     CHiking hiking;
-    hiking.setComputeType(CHiking::OPTIMIZED);
+    hiking.setComputeType(bParallel ? CHiking::OPTIMIZED_PARALLEL : CHiking::OPTIMIZED);
+    hiking.setVerifier(verifier);
 
     CConfig confObj(configFile);
     confObj.readConfigAndTriggerEvents(hiking);
@@ -77,17 +81,24 @@ bool validateBridgeCrossAlgosGiveSameResult() {
             std::cout << "Debug, as we get different results from different approaches.";
             return false;
         }
+
+        // Parallel evaluation must be exactly the same as crossing the bridges in order.
+        double hikeTime_from_parallel = crossBridgeOptimizedApproach(testFile, nullptr, true);
+        if (hikeTime_from_parallel != hikeTime_from_optimized_approach) {
+            std::cout << "Debug, as we get different results from the parallel evaluation.";
+            return false;
+        }
     }
     // This means both approaches give the same result, hence we can use optimal approach going forward.
     return true;
 }
 
 // Get the total hiking time to cross all bridges using optimal method.
-void getTimeTakenByHikersToCrossAllBridges(const std::string& configFile) {
+void getTimeTakenByHikersToCrossAllBridges(const std::string& configFile, CVerifier* verifier, bool bParallel) {
 
     auto start_1 = std::chrono::high_resolution_clock::now();
 
-    double hikeTime_from_optimized_approach = crossBridgeOptimizedApproach(configFile);
+    double hikeTime_from_optimized_approach = crossBridgeOptimizedApproach(configFile, verifier, bParallel);
 
     auto end_1 = std::chrono::high_resolution_clock::now();
     auto duration_1 = std::chrono::duration_cast<std::chrono::microseconds>(end_1 - start_1);
@@ -101,9 +112,23 @@ void getTimeTakenByHikersToCrossAllBridges(const std::string& configFile) {
 
 
 
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [--parallel] [--profile] [--verify-sample <rate>] [--verify-budget <fraction>]"
+              << " [--verify-max-hikers <n>] [--verify-deadline <ms>] [config.yaml]" << std::endl;
+}
+
 // Main:
 // Caller may pass config file (yaml) as argument in the command line.
 // Otherwise, the default one will be used.
+//
+// Options:
+//   --parallel                  Evaluate the bridges on all cores, same result as sequential.
+//   --profile                   Print the allocations and memory used by each subsystem at exit.
+//   --verify-sample <rate>      Re-solve the given fraction of the bridge crossings with
+//                               the exhaustive approach in background and report mismatches.
+//   --verify-budget <fraction>  Cpu budget of the background verifier, fraction of a core.
+//   --verify-max-hikers <n>     Largest group to verify, larger ones are skipped.
+//   --verify-deadline <ms>      Time limit of the exhaustive approach per crossing above 20 hikers.
 
 int main(int argc, char* argv[]) {
 
@@ -112,20 +137,71 @@ int main(int argc, char* argv[]) {
     //setDebugLevels(DEBUG_TRACE | DEBUG_WARNING | DEBUG_INFO | DEBUG_ERROR | DEBUG_INTER | DEBUG_STEPS);
     //setDebugLevels(DEBUG_INTER);
 
+    std::string configFile = "hiking_event_default.yaml";
+    SVerifierConfig verifierConfig;
+    bool bVerify = false;
+    bool bParallel = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--parallel") {
+                bParallel = true;
+            }
+            else if (arg == "--profile") {
+                if (!bIsProfiling()) {
+                    setProfiling(true);
+                    std::atexit(printProfile);
+                }
+            }
+            else if (arg == "--verify-sample" && i + 1 < argc) {
+                verifierConfig.sampleRate = std::stod(argv[++i]);
+                bVerify = true;
+            }
+            else if (arg == "--verify-budget" && i + 1 < argc) {
+                verifierConfig.cpuBudget = std::stod(argv[++i]);
+            }
+            else if (arg == "--verify-max-hikers" && i + 1 < argc) {
+                verifierConfig.maxHikers = std::stoul(argv[++i]);
+            }
+            else if (arg == "--verify-deadline" && i + 1 < argc) {
+                verifierConfig.sampleTimeLimit = std::chrono::milliseconds(std::stoul(argv[++i]));
+            }
+            else if (arg.size() > 1 && arg[0] == '-') {
+                printUsage(argv[0]);
+                return -1;
+            }
+            else {
+                configFile = arg;
+            }
+        }
+        catch (std::exception& ex) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+
     if (!validateBridgeCrossAlgosGiveSameResult()) {
         std::cerr << "exiting as algo is not giving correct output yet" << std::endl;
         return -1;
     }
 
-    std::string configFile;
-    if (argc == 2) {
-        configFile = argv[1];
-    }
-    else {
-        configFile = "hiking_event_default.yaml";
+    CVerifier verifier(verifierConfig);
+    if (bVerify) {
+        verifier.start();
     }
 
-    getTimeTakenByHikersToCrossAllBridges(configFile);
+    getTimeTakenByHikersToCrossAllBridges(configFile, bVerify ? &verifier : nullptr, bParallel);
+
+    if (bVerify) {
+        // Pending samples are verified before exit.
+        verifier.stop(true);
+        verifier.printStats();
+        if (verifier.getStats().mismatches) {
+            return -1;
+        }
+    }
 
     return 0;
 }
@@ -0,0 +1,125 @@
+// File: profile.cpp
+//
+// Allocation counters per subsystem and the summary printed at exit.
+// Nothing here may allocate, as it is called from operator new/delete.
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "profile.h"
+
+namespace {
+
+struct SCounters {
+    std::atomic<uint64_t> allocs;
+    std::atomic<uint64_t> frees;
+    std::atomic<uint64_t> bytes;      // Bytes requested in total
+    std::atomic<int64_t>  peakHeap;   // Peak heap in use while the subsystem ran
+};
+
+std::atomic<bool>    g_profiling(false);
+SCounters            g_counters[PROFILE_COUNT];
+std::atomic<int64_t> g_heapInUse(0);
+std::atomic<int64_t> g_peakHeap(0);
+
+thread_local eProfileSubsystem t_subsystem = PROFILE_OTHER;
+
+const char* subsystemNames[PROFILE_COUNT] = { "other", "parser", "optimized", "exhaustive" };
+
+void updateMax(std::atomic<int64_t>& peak, int64_t value) {
+    int64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+// Peak resident memory of the process in KB
+long peakResidentKB() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;  // in bytes
+#else
+    return usage.ru_maxrss;         // in KB
+#endif
+#endif
+}
+
+} // namespace
+
+void setProfiling(bool enable) {
+    g_profiling.store(enable, std::memory_order_relaxed);
+}
+
+bool bIsProfiling() {
+    return g_profiling.load(std::memory_order_relaxed);
+}
+
+eProfileSubsystem profileAlloc(size_t size) {
+    if (!bIsProfiling()) {
+        return PROFILE_COUNT;
+    }
+    SCounters& counters = g_counters[t_subsystem];
+    int64_t bytes = static_cast<int64_t>(size);
+
+    counters.allocs.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    int64_t inUse = g_heapInUse.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    updateMax(g_peakHeap, inUse);
+    updateMax(counters.peakHeap, inUse);
+    return t_subsystem;
+}
+
+// Free is counted against the subsystem that allocated the block.
+void profileFree(size_t size, eProfileSubsystem subsystem) {
+    if (subsystem >= PROFILE_COUNT) {
+        return;
+    }
+    g_counters[subsystem].frees.fetch_add(1, std::memory_order_relaxed);
+    g_heapInUse.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+}
+
+void printProfile() {
+    std::cout << "Profile: " << std::left << std::setw(12) << "subsystem" << std::right
+              << std::setw(14) << "allocs" << std::setw(14) << "frees"
+              << std::setw(18) << "bytes allocated" << std::setw(16) << "peak heap" << std::endl;
+
+    for (int i = 0; i < PROFILE_COUNT; ++i) {
+        std::cout << "Profile: " << std::left << std::setw(12) << subsystemNames[i] << std::right
+                  << std::setw(14) << g_counters[i].allocs.load()
+                  << std::setw(14) << g_counters[i].frees.load()
+                  << std::setw(18) << g_counters[i].bytes.load()
+                  << std::setw(16) << g_counters[i].peakHeap.load() << std::endl;
+    }
+    std::cout << "Profile: peak heap in use: " << g_peakHeap.load() << " bytes, peak resident memory: "
+              << peakResidentKB() << " KB" << std::endl;
+}
+
+
+CProfileScope::CProfileScope(eProfileSubsystem subsystem) : previous(t_subsystem) {
+    t_subsystem = subsystem;
+}
+
+CProfileScope::~CProfileScope() {
+    t_subsystem = previous;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+
+// File: profile.h
+//
+// Allocation and memory footprint profiling for sizing the hosts and spotting
+// allocation regressions without external tools.
+//
+// When profiling is on, every allocation is counted against the subsystem
+// running on that thread (parser, optimized approach, exhaustive approach)
+// along with the bytes allocated and the peak heap in use while it ran.
+// Summary with the peak resident memory of the process is printed at exit.
+//
+// Allocations are seen through the replaced global operator new/delete in
+// profilealloc.cpp, which is linked into the hike binary only. Library users
+// may link it too, otherwise nothing is counted. It costs a header of 16 bytes
+// (alignment of malloc) per allocation and a flag check, even when profiling
+// is off.
+//
+// Example:
+//      void CConfig::readEventsAndTriggerEvents(...) {
+//          CProfileScope profileScope(PROFILE_PARSER);
+//          ...
+//      }
+
+enum eProfileSubsystem {
+    PROFILE_OTHER      = 0,  // Anything outside of the subsystems below
+    PROFILE_PARSER     = 1,  // Config parser
+    PROFILE_OPTIMIZED  = 2,  // Optimized approach
+    PROFILE_EXHAUSTIVE = 3,  // Exhaustive approach, anytime search and the verifier
+    PROFILE_COUNT      = 4,
+};
+
+void setProfiling(bool enable);
+bool bIsProfiling();
+
+// Print the per subsystem summary.
+void printProfile();
+
+// Hooks for the allocator with the size requested, called after malloc and
+// before free. profileAlloc returns the subsystem the block is counted against,
+// PROFILE_COUNT when it is not counted (profiling is off). Only the counted
+// blocks are passed to profileFree, so the blocks allocated before profiling
+// was on don't skew the heap in use.
+eProfileSubsystem profileAlloc(size_t size);
+void profileFree(size_t size, eProfileSubsystem subsystem);
+
+// Allocations on this thread are counted against the subsystem while in scope.
+class CProfileScope {
+
+public:
+    CProfileScope(eProfileSubsystem subsystem);
+    ~CProfileScope();
+
+private:
+    CProfileScope() = delete;
+    CProfileScope(const CProfileScope&) = delete;
+    CProfileScope& operator = (const CProfileScope&) = delete;
+
+    eProfileSubsystem previous;
+};
@@ -0,0 +1,109 @@
+// File: profilealloc.cpp
+//
+// Replacement of the global operator new/delete that reports the allocations
+// to the profiler (profile.h). Only counted when profiling is on.
+//
+// Each block has a small header in front with the size requested and the
+// subsystem it was counted against, so that only the frees of the counted
+// blocks are reported. Header takes the alignment of malloc (16 bytes on
+// x86-64) so that the blocks stay aligned.
+
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "profile.h"
+
+namespace {
+
+struct SBlockHeader {
+    std::size_t       size;
+    eProfileSubsystem subsystem;
+};
+
+const std::size_t headerSize = alignof(std::max_align_t);
+static_assert(sizeof(SBlockHeader) <= headerSize, "Block header must fit in the alignment of malloc");
+
+void* allocate(std::size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    if (size > SIZE_MAX - headerSize) {
+        return nullptr;
+    }
+    char* block = static_cast<char*>(std::malloc(headerSize + size));
+    if (!block) {
+        return nullptr;
+    }
+    SBlockHeader* header = reinterpret_cast<SBlockHeader*>(block);
+    header->size      = size;
+    header->subsystem = profileAlloc(size);
+    return block + headerSize;
+}
+
+void* allocateOrThrow(std::size_t size) {
+    while (true) {
+        void* ptr = allocate(size);
+        if (ptr) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void deallocate(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    char* block = static_cast<char*>(ptr) - headerSize;
+    SBlockHeader* header = reinterpret_cast<SBlockHeader*>(block);
+    profileFree(header->size, header->subsystem);
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    return allocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    deallocate(ptr);
+}
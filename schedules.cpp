@@ -0,0 +1,234 @@
+// File: schedules.cpp
+//
+// Count, enumerate and sample the optimal schedules of a group crossing a
+// bridge, using dynamic programming over the states of the exhaustive approach.
+
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+
+#include "schedules.h"
+#include "solverutil.h"
+
+const size_t COptimalSchedules::maxHikers;
+
+
+COptimalSchedules::COptimalSchedules(const std::vector<SHiker>& hikers, double bridgeLength)
+    : hikers(hikers), all(0), bSaturated(false)
+{
+    if (hikers.size() > maxHikers) {
+        throw std::out_of_range("Too many hikers to count the optimal schedules");
+    }
+    for (size_t i = 0; i < hikers.size(); ++i) {
+        times.push_back(bridgeLength / hikers[i].speed);
+        all |= uint32_t(1) << i;
+    }
+    computeStates();
+}
+
+COptimalSchedules::~COptimalSchedules() {
+}
+
+double COptimalSchedules::getOptimalTime() const {
+    return all ? forward[all].time : 0;
+}
+
+uint64_t COptimalSchedules::getCount() const {
+    return all ? forward[all].count : 1;
+}
+
+bool COptimalSchedules::isCountSaturated() const {
+    return bSaturated;
+}
+
+double COptimalSchedules::legTime(int a, int b) const {
+    return (b < 0) ? times[a] : std::max(times[a], times[b]);
+}
+
+// States are computed in the order of the hikers on the left. Forward moves
+// take two hikers off the left and backward moves bring one back, so
+//   forward  with s hikers on the left depends on backward with s-2 on the left,
+//   backward with s hikers on the left depends on forward  with s+1 on the left.
+void COptimalSchedules::computeStates() {
+
+    size_t n = times.size();
+    if (!n) {
+        return;
+    }
+    forward.assign(size_t(1) << n, SState{ infinity, 0 });
+    backward.assign(size_t(1) << n, SState{ infinity, 0 });
+
+    auto addCount = [this](uint64_t& count, uint64_t more) {
+        if (count > std::numeric_limits<uint64_t>::max() - more) {
+            count = std::numeric_limits<uint64_t>::max();
+            bSaturated = true;
+        }
+        else {
+            count += more;
+        }
+    };
+
+    // Optimal time and the number of ways to get it, after a forward move
+    auto afterForward = [this](uint32_t left) {
+        return left ? backward[left] : SState{ 0, 1 };
+    };
+
+    for (size_t s = 1; s <= n; ++s) {
+
+        for (uint32_t left = 1; left <= all; ++left) {
+            if (countHikers(left) != s) {
+                continue;
+            }
+            SState& state = forward[left];
+
+            // Lone hiker crosses alone, otherwise any pair from the left goes forward.
+            for (int pass = 0; pass < 2; ++pass) {
+                for (int a = 0; a < static_cast<int>(n); ++a) {
+                    if (!(left & (uint32_t(1) << a))) {
+                        continue;
+                    }
+                    for (int b = (s == 1) ? -1 : a + 1; b < static_cast<int>(n); b = (b < 0) ? n : b + 1) {
+                        if (b >= 0 && !(left & (uint32_t(1) << b))) {
+                            continue;
+                        }
+                        uint32_t rest = left & ~(uint32_t(1) << a) & ~(b < 0 ? 0 : uint32_t(1) << b);
+                        SState next = afterForward(rest);
+                        double time = legTime(a, b) + next.time;
+                        if (pass == 0) {
+                            state.time = std::min(state.time, time);
+                        }
+                        else if (isSameTime(time, state.time)) {
+                            addCount(state.count, next.count);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Backward with one hiker less on the left
+        for (uint32_t left = 1; left < all; ++left) {
+            if (countHikers(left) != s - 1) {
+                continue;
+            }
+            SState& state = backward[left];
+            uint32_t right = all & ~left;
+
+            for (int pass = 0; pass < 2; ++pass) {
+                for (int c = 0; c < static_cast<int>(n); ++c) {
+                    if (!(right & (uint32_t(1) << c))) {
+                        continue;
+                    }
+                    const SState& next = forward[left | (uint32_t(1) << c)];
+                    double time = times[c] + next.time;
+                    if (pass == 0) {
+                        state.time = std::min(state.time, time);
+                    }
+                    else if (isSameTime(time, state.time)) {
+                        addCount(state.count, next.count);
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::string COptimalSchedules::describeMove(int a, int b, bool bForward) const {
+    std::stringstream ss;
+    if (bForward) {
+        ss << hikers[a].name;
+        if (b >= 0) {
+            ss << ", " << hikers[b].name;
+        }
+        ss << " (" << legTime(a, b) << ") -->";
+    }
+    else {
+        ss << "<-- " << hikers[a].name << " (" << times[a] << ")";
+    }
+    return ss.str();
+}
+
+// Walk down the optimal moves from the start, skipping over the schedules
+// under each move till the one with the index is reached.
+std::vector<std::string> COptimalSchedules::getSchedule(uint64_t index) const {
+
+    if (index >= getCount()) {
+        throw std::out_of_range("Index of the optimal schedule is out of range");
+    }
+
+    std::vector<std::string> schedule;
+    int n = static_cast<int>(times.size());
+    uint32_t left = all;
+
+    while (left) {
+        bool bMoved = false;
+
+        // Forward move
+        size_t s = countHikers(left);
+        for (int a = 0; a < n && !bMoved; ++a) {
+            if (!(left & (uint32_t(1) << a))) {
+                continue;
+            }
+            for (int b = (s == 1) ? -1 : a + 1; b < n; b = (b < 0) ? n : b + 1) {
+                if (b >= 0 && !(left & (uint32_t(1) << b))) {
+                    continue;
+                }
+                uint32_t rest = left & ~(uint32_t(1) << a) & ~(b < 0 ? 0 : uint32_t(1) << b);
+                double   time  = legTime(a, b) + (rest ? backward[rest].time : 0);
+                uint64_t count = rest ? backward[rest].count : 1;
+                if (!isSameTime(time, forward[left].time)) {
+                    continue;
+                }
+                if (index >= count) {
+                    index -= count;
+                    continue;
+                }
+                schedule.push_back(describeMove(a, b, true));
+                left = rest;
+                bMoved = true;
+                break;
+            }
+        }
+        if (!left) {
+            break;
+        }
+
+        // Backward move
+        uint32_t right = all & ~left;
+        for (int c = 0; c < n; ++c) {
+            if (!(right & (uint32_t(1) << c))) {
+                continue;
+            }
+            const SState& next = forward[left | (uint32_t(1) << c)];
+            if (!isSameTime(times[c] + next.time, backward[left].time)) {
+                continue;
+            }
+            if (index >= next.count) {
+                index -= next.count;
+                continue;
+            }
+            schedule.push_back(describeMove(c, -1, false));
+            left |= uint32_t(1) << c;
+            break;
+        }
+    }
+    return schedule;
+}
+
+std::vector<std::string> COptimalSchedules::sample(std::mt19937_64& rng) const {
+    std::uniform_int_distribution<uint64_t> dist(0, getCount() - 1);
+    return getSchedule(dist(rng));
+}
+
+
+COptimalSchedules::CIterator::CIterator(const COptimalSchedules& schedules)
+    : schedules(schedules), index(0) {}
+
+bool COptimalSchedules::CIterator::next(std::vector<std::string>& schedule) {
+    if (index >= schedules.getCount()) {
+        return false;
+    }
+    schedule = schedules.getSchedule(index++);
+    return true;
+}
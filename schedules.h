@@ -0,0 +1,80 @@
+#pragma once
+
+// File: schedules.h
+//
+// All optimal schedules of a group crossing a bridge, without keeping each of
+// them in memory.
+//
+// Dynamic programming over the states of the exhaustive approach (hikers left
+// on the left side and the side of the torch) gives the optimal time still
+// needed from every state and the number of optimal ways to get there. From
+// these, the number of distinct optimal schedules is known exactly and any of
+// them can be built on demand by its index. Memory is bounded by the number of
+// states (2^n for n hikers) and not by the number of schedules.
+//
+// Example:
+//      COptimalSchedules schedules(hikers, bridge.length);
+//      std::cout << schedules.getCount() << " schedules in " << schedules.getOptimalTime();
+//
+//      COptimalSchedules::CIterator it(schedules);
+//      std::vector<std::string> schedule;
+//      while (it.next(schedule)) { ... }
+//
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "hiker.h"
+
+class COptimalSchedules {
+
+public:
+    COptimalSchedules(const std::vector<SHiker>& hikers, double bridgeLength);
+    ~COptimalSchedules();
+
+    double   getOptimalTime() const;
+    uint64_t getCount() const;         // Number of distinct optimal schedules
+    bool     isCountSaturated() const; // Count didn't fit in 64 bits, it is UINT64_MAX
+
+    // Moves of the optimal schedule with the given index, in [0, getCount())
+    std::vector<std::string> getSchedule(uint64_t index) const;
+
+    // Optimal schedule picked uniformly at random
+    std::vector<std::string> sample(std::mt19937_64& rng) const;
+
+    // Goes over all the optimal schedules one at a time.
+    class CIterator {
+    public:
+        CIterator(const COptimalSchedules& schedules);
+        bool next(std::vector<std::string>& schedule);
+    private:
+        const COptimalSchedules& schedules;
+        uint64_t index;
+    };
+
+    // Max hikers supported, the states are kept for each subset of hikers.
+    static const size_t maxHikers = 20;
+
+private:
+    COptimalSchedules() = delete;
+
+    // Optimal time still needed and the number of ways to get it, from a state
+    struct SState {
+        double   time;
+        uint64_t count;
+    };
+
+    void   computeStates();
+    double legTime(int a, int b) const;
+    std::string describeMove(int a, int b, bool bForward) const;
+
+    std::vector<SHiker> hikers;
+    std::vector<double> times;    // Time for each hiker to cross alone
+    uint32_t            all;
+    bool                bSaturated;
+
+    std::vector<SState> forward;  // Torch on the left, indexed by hikers on the left
+    std::vector<SState> backward; // Torch on the right, indexed by hikers on the left
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+// File: solverutil.h
+//
+// Helpers shared by the exact solvers (anytime search, optimal schedules and
+// the verifier) and the sorting of the hikers.
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "hiker.h"
+
+const double infinity = std::numeric_limits<double>::infinity();
+
+// Number of hikers in the bitmask of hikers
+inline size_t countHikers(uint64_t mask) {
+    size_t count = 0;
+    for (; mask; mask &= mask - 1) {
+        ++count;
+    }
+    return count;
+}
+
+// Times of different schedules are added in different order, so the ones
+// within the rounding error of the time are taken as the same.
+inline double timeTolerance(double time) {
+    return 1e-9 * std::max(1.0, std::fabs(time));
+}
+
+inline bool isSameTime(double a, double b) {
+    return std::fabs(a - b) <= timeTolerance(b);
+}
+
+// Order of the hikers from the fastest to the slowest
+inline bool bySpeed(const SHiker& a, const SHiker& b) {
+    return a.speed > b.speed;
+}
@@ -0,0 +1,235 @@
+// File: verifier.cpp
+//
+// Background verifier that re-solves a random sample of the real bridge
+// crossings with the exact approach and reports the disagreements with
+// the optimized approach.
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "verifier.h"
+#include "anytime.h"
+#include "schedules.h"
+#include "debug.h"
+#include "profile.h"
+#include "solverutil.h"
+
+SVerifierConfig::SVerifierConfig() : sampleRate(0.01), cpuBudget(0.1), maxHikers(12),
+                                     sampleTimeLimit(std::chrono::milliseconds(50)),
+                                     queueSize(16), seed(0x5eed) {}
+
+CVerifier::CVerifier(const SVerifierConfig& config) : config(config), bStop(false), bDrain(false),
+                                                      sequence(0), sampled(0), verified(0),
+                                                      mismatches(0), inconclusive(0), dropped(0), skipped(0)
+{
+}
+
+CVerifier::~CVerifier() {
+    stop(false);
+}
+
+void CVerifier::start() {
+    if (!worker.joinable()) {
+        bStop = false;
+        worker = std::thread(&CVerifier::run, this);
+    }
+}
+
+void CVerifier::stop(bool drain) {
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(samplesMutex);
+            bStop  = true;
+            bDrain = drain;
+        }
+        samplesCond.notify_one();
+        worker.join();
+    }
+}
+
+// Pick the crossing for verification with the probability of sample rate.
+// Uses the splitmix64 hash of the crossing sequence so that it is lock free
+// and the same crossings are picked for the same seed.
+bool CVerifier::isSampled() {
+    if (config.sampleRate <= 0) {
+        return false;
+    }
+    if (config.sampleRate >= 1) {
+        return true;
+    }
+    uint64_t z = config.seed + sequence.fetch_add(1, std::memory_order_relaxed) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z = z ^ (z >> 31);
+    return (z >> 11) * (1.0 / 9007199254740992.0) < config.sampleRate;
+}
+
+// Count the sampled crossing, returns false if it is not sampled or too large to verify.
+bool CVerifier::isAccepted(size_t numHikers) {
+
+    if (!isSampled()) {
+        return false;
+    }
+    sampled.fetch_add(1, std::memory_order_relaxed);
+
+    if (numHikers > std::min(config.maxHikers, CAnytimeSearch::maxHikers)) {
+        skipped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void CVerifier::pushSample(SSample& sample) {
+
+    // Never wait for the verifier, drop the sample if it is busy.
+    std::unique_lock<std::mutex> lock(samplesMutex, std::try_to_lock);
+    if (!lock.owns_lock() || bStop || samples.size() >= config.queueSize) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    samples.push_back(std::move(sample));
+
+    lock.unlock();
+    samplesCond.notify_one();
+}
+
+void CVerifier::submit(const std::vector<SHiker>& hikers, double bridgeLength, double timeToCross) {
+
+    if (!isAccepted(hikers.size())) {
+        return;
+    }
+
+    SSample sample;
+    sample.speeds.reserve(hikers.size());
+    for (auto& hiker : hikers) {
+        sample.speeds.push_back(hiker.speed);
+    }
+    sample.bridgeLength = bridgeLength;
+    sample.timeToCross  = timeToCross;
+    pushSample(sample);
+}
+
+void CVerifier::submit(const std::vector<double>& speeds, double bridgeLength, double timeToCross) {
+
+    if (!isAccepted(speeds.size())) {
+        return;
+    }
+
+    SSample sample;
+    sample.speeds       = speeds;
+    sample.bridgeLength = bridgeLength;
+    sample.timeToCross  = timeToCross;
+    pushSample(sample);
+}
+
+void CVerifier::run() {
+
+#ifdef __linux__
+    // Lowest priority for this thread only
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#endif
+
+    double budget = std::min(1.0, std::max(config.cpuBudget, 0.001));
+
+    while (true) {
+        SSample sample;
+        {
+            std::unique_lock<std::mutex> lock(samplesMutex);
+            samplesCond.wait(lock, [this] { return bStop || !samples.empty(); });
+            if (samples.empty() || (bStop && !bDrain)) {
+                break;
+            }
+            sample = std::move(samples.front());
+            samples.pop_front();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        verify(sample);
+        auto busy = std::chrono::steady_clock::now() - start;
+
+        // Stay within the cpu budget by idling in proportion to the time spent.
+        if (budget < 1) {
+            auto idle = std::chrono::duration_cast<std::chrono::microseconds>(busy * ((1 - budget) / budget));
+            std::unique_lock<std::mutex> lock(samplesMutex);
+            samplesCond.wait_for(lock, idle, [this] { return bStop; });
+        }
+    }
+}
+
+// Re-solve the crossing with the exact approach and compare.
+void CVerifier::verify(const SSample& sample) {
+
+    CProfileScope profileScope(PROFILE_EXHAUSTIVE);
+
+    std::vector<SHiker> hikers;
+    for (auto speed : sample.speeds) {
+        hikers.push_back(SHiker("", speed));
+    }
+
+    SSearchResult result;
+    if (hikers.size() <= COptimalSchedules::maxHikers) {
+        COptimalSchedules schedules(hikers, sample.bridgeLength);
+        result.bComplete  = true;
+        result.bestCost   = schedules.getOptimalTime();
+        result.lowerBound = result.bestCost;
+    }
+    else {
+        CAnytimeSearch exact(hikers, sample.bridgeLength);
+        result = exact.search(SSearchBudget(0, config.sampleTimeLimit));
+    }
+
+    // Both approaches add the leg times in different order.
+    double tolerance = timeTolerance(result.bestCost);
+
+    // Optimized time must not be worse than a schedule found, nor better than proven possible.
+    if (sample.timeToCross > result.bestCost + tolerance ||
+        sample.timeToCross < result.lowerBound - tolerance) {
+        mismatches.fetch_add(1, std::memory_order_relaxed);
+
+        std::cerr << "Verifier: mismatch for bridge length " << sample.bridgeLength << ", hikers:";
+        for (auto speed : sample.speeds) {
+            std::cerr << " " << speed;
+        }
+        std::cerr << ", optimized: " << sample.timeToCross << ", exact: " << result.bestCost;
+        if (!result.bComplete) {
+            std::cerr << " (lower bound: " << result.lowerBound << ")";
+        }
+        std::cerr << std::endl;
+    }
+    else if (!result.bComplete) {
+        inconclusive.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    else if (bIsDebug(DEBUG_INFO)) {
+        std::cout << "Verifier: verified crossing with " << sample.speeds.size()
+                  << " hikers, time: " << result.bestCost << std::endl;
+    }
+    verified.fetch_add(1, std::memory_order_relaxed);
+}
+
+SVerifierStats CVerifier::getStats() const {
+    SVerifierStats stats;
+    stats.sampled    = sampled.load(std::memory_order_relaxed);
+    stats.verified   = verified.load(std::memory_order_relaxed);
+    stats.mismatches = mismatches.load(std::memory_order_relaxed);
+    stats.inconclusive = inconclusive.load(std::memory_order_relaxed);
+    stats.dropped    = dropped.load(std::memory_order_relaxed);
+    stats.skipped    = skipped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void CVerifier::printStats() const {
+    SVerifierStats stats = getStats();
+    std::cout << "Verifier: sampled: " << stats.sampled << ", verified: " << stats.verified
+              << ", mismatches: " << stats.mismatches << ", inconclusive: " << stats.inconclusive
+              << ", dropped: " << stats.dropped
+              << ", skipped: " << stats.skipped << std::endl;
+}
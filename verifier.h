@@ -0,0 +1,105 @@
+#pragma once
+
+// File: verifier.h
+//
+// Background verifier that re-solves a random sample of the real bridge
+// crossings with the exact (exhaustive) approach and cross checks the
+// result of the optimized approach.
+//
+// Groups of up to 20 hikers are solved exactly by the dynamic programming of
+// COptimalSchedules, which shares nothing with the optimized approach. By
+// default only groups of up to 12 hikers are verified, which takes about 10ms.
+// Larger groups, when allowed, are run as the anytime search with a deadline
+// per sample. If the search can't complete by the deadline, the optimized
+// result is only checked against the proven lower bound and any better
+// schedule found, and counted as inconclusive. The best schedule the search
+// starts with is the optimized one, so it verifies nothing by itself.
+//
+// The hiking module only hands over a sample and never waits on the
+// verifier. If the verifier is busy or its queue is full, the sample is
+// dropped and counted. Verifier thread runs at low priority and sleeps
+// between the samples to stay within the configured cpu budget.
+
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+#include <chrono>
+
+#include "hiker.h"
+
+// Verifier settings
+struct SVerifierConfig {
+    double   sampleRate;  // Fraction of the bridge crossings to verify [0, 1]
+    double   cpuBudget;   // Fraction of one core the verifier may use (0, 1]
+    size_t   maxHikers;   // Larger groups are skipped, the default is solved well within the time limit
+    std::chrono::microseconds sampleTimeLimit;  // Time limit of the exact search per sample
+    size_t   queueSize;   // Max pending samples, new samples are dropped when full
+    uint64_t seed;        // Seed for picking the samples
+
+    SVerifierConfig();
+};
+
+// Verifier metrics
+struct SVerifierStats {
+    uint64_t sampled;     // Crossings picked for verification
+    uint64_t verified;    // Crossings whose exact time was found and compared
+    uint64_t mismatches;  // Crossings where both approaches disagree
+    uint64_t inconclusive; // Exact search did not complete, but bounds agree
+    uint64_t dropped;     // Samples dropped as verifier was busy
+    uint64_t skipped;     // Samples skipped as group was too large
+};
+
+class CVerifier {
+
+public:
+    CVerifier(const SVerifierConfig& config);
+    ~CVerifier();
+
+    void start();               // Start the background thread
+    void stop(bool drain);      // Stop the thread, optionally after verifying pending samples
+
+    // Called for every crossing by the optimized approach. Never blocks.
+    void submit(const std::vector<SHiker>& hikers, double bridgeLength, double timeToCross);
+    void submit(const std::vector<double>& speeds, double bridgeLength, double timeToCross);
+
+    SVerifierStats getStats() const;
+    void printStats() const;
+
+private:
+    struct SSample {
+        std::vector<double> speeds;
+        double bridgeLength;
+        double timeToCross;
+    };
+
+    CVerifier() = delete;
+    CVerifier(const CVerifier&) = delete;
+    CVerifier& operator = (const CVerifier&) = delete;
+
+    bool isSampled();
+    bool isAccepted(size_t numHikers);
+    void pushSample(SSample& sample);
+    void run();
+    void verify(const SSample& sample);
+
+    SVerifierConfig config;
+
+    std::deque<SSample>     samples;
+    std::mutex              samplesMutex;
+    std::condition_variable samplesCond;
+    std::thread             worker;
+    bool                    bStop;
+    bool                    bDrain;
+
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> sampled;
+    std::atomic<uint64_t> verified;
+    std::atomic<uint64_t> mismatches;
+    std::atomic<uint64_t> inconclusive;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> skipped;
+};